@@ -0,0 +1,422 @@
+// compressedGraph.hpp
+
+#ifndef COMPRESSED_GRAPH_HPP
+#define COMPRESSED_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include "graph.hpp"
+
+/**
+ * @brief Appends x to out as a varint (7 bits per byte, high bit set on all
+ * but the last byte).
+ *
+ * @param out The byte buffer.
+ * @param x The value to be encoded.
+ */
+inline void encodeVarint(std::vector<uint8_t> &out, uint32_t x) {
+    while (x >= 0x80) {
+        out.push_back(uint8_t(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(uint8_t(x));
+}
+
+/**
+ * @brief Decodes one varint starting at ptr and advances ptr past it.
+ *
+ * @param ptr Pointer to the first byte of the varint.
+ * @return uint32_t The decoded value.
+ */
+inline uint32_t decodeVarint(const uint8_t *&ptr) {
+    uint32_t x = *ptr++;
+    if (x < 0x80) // most gaps fit in one byte
+        return x;
+    x &= 0x7f;
+    for (int shift = 7; ; shift += 7) {
+        uint32_t b = *ptr++;
+        x |= (b & 0x7f) << shift;
+        if (b < 0x80)
+            return x;
+    }
+}
+
+// maps signed to unsigned so that small magnitudes get short varints
+inline uint32_t zigzagEncode(int32_t x) { return (uint32_t(x) << 1) ^ uint32_t(x >> 31); }
+inline int32_t zigzagDecode(uint32_t x) { return int32_t(x >> 1) ^ -int32_t(x & 1); }
+
+/**
+ * @brief Read-only adjacency storage shared by compressedGraph and
+ * compressedWeightedGraph. Every neighbour list is sorted and stored as gaps
+ * between consecutive neighbours, each gap being a varint. The first gap is
+ * taken from the vertex itself and zigzag encoded. If weighted, each gap is
+ * followed by the zigzag varint of the edge weight.
+ *
+ * List starts are kept as a 64 bit base every 64 vertices plus a 32 bit
+ * offset per vertex, about 4.1 bytes per vertex.
+ *
+ * Measured with memoryUsage() against the size of Graph / weightedGraph
+ * (4 or 8 bytes per edge plus 24 per vector), 1M vertices and 10M edges:
+ *     local edges (v - u < 64)    unweighted 1.4 B/edge (4.5x),
+ *                                 weighted   3.3 B/edge (3.1x, weights < 1000)
+ *     uniformly random edges      unweighted 3.3 B/edge (1.9x),
+ *                                 weighted   5.2 B/edge (2.0x)
+ * Random neighbours carry about log2(V / degree) bits each, so no gap code
+ * gets such graphs to 3x; renumbering vertices for locality (e.g. BFS order)
+ * is what brings a graph into the first regime.
+ *
+ * @tparam weighted true if the edges carry weights.
+ */
+template <bool weighted>
+class compressedAdjacency {
+
+    protected:
+        /**
+         * Number of Vertices.
+         *
+         */
+        Vertex V;
+
+        /**
+         * The list of vertex u starts at data[blockStart[u >> 6] + offset[u]]
+         * and ends where the list of u + 1 starts.
+         *
+         */
+        std::vector<uint64_t> blockStart;
+        std::vector<uint32_t> offset;
+
+        /**
+         * Encoded neighbour lists of all vertices.
+         *
+         */
+        std::vector<uint8_t> data;
+
+        /**
+         * Number of stored edges.
+         *
+         */
+        size_t edgeCount;
+
+        /**
+         * @brief Records that the list of vertex u starts at data[start].
+         * Called for u = 0, 1, ..., V + 1 in this order.
+         *
+         */
+        void setStart(Vertex u, uint64_t start) {
+            if ((u & 63) == 0)
+                blockStart[u >> 6] = start;
+            uint64_t rel = start - blockStart[u >> 6];
+            if (rel > UINT32_MAX)
+                throw std::length_error("compressedAdjacency: lists of 64 consecutive "
+                                        "vertices exceed 4 GiB");
+            offset[u] = uint32_t(rel);
+        }
+
+        inline const uint8_t* start(Vertex u) const {
+            return data.data() + blockStart[u >> 6] + offset[u];
+        }
+
+        /**
+         * @brief Encodes every list straight into data, so only one uncompressed
+         * list is held in memory at a time.
+         *
+         * @param _V Number of vertices.
+         * @param listOf listOf(u, list) appends the neighbours of u to the empty
+         * list, as Edge(v, weight). Called for u = 0, 1, ..., V in this order.
+         */
+        template <class ListFn>
+        void build(Vertex _V, ListFn listOf) {
+            V = _V;
+            blockStart.assign(((V + 1) >> 6) + 1, 0);
+            offset.assign(V + 2, 0);
+            data.clear();
+            edgeCount = 0;
+            std::vector<Edge> list;
+            setStart(0, 0);
+            for (Vertex u = 0; u <= V; ++u) {
+                list.clear();
+                listOf(u, list);
+                appendList(u, list);
+                setStart(u + 1, data.size());
+            }
+            data.shrink_to_fit();
+        }
+
+        /**
+         * @brief Encodes a stream of directed edges (u, x) grouped by u in
+         * increasing order, in a single pass.
+         *
+         * @param _V Number of vertices.
+         * @param first Input iterator to the first pair (u, x).
+         * @param last Input iterator past the last pair.
+         * @param toEdge toEdge(x) gives the Edge(v, weight) stored for u.
+         * @throws std::invalid_argument if the stream is not grouped by source
+         * in increasing order or holds a vertex outside [1, V]. The check is
+         * done as the stream is read, so no edge is dropped silently.
+         */
+        template <class InputIt, class ToEdge>
+        void buildFromStream(Vertex _V, InputIt &first, InputIt last, ToEdge toEdge) {
+            build(_V, [&](Vertex u, std::vector<Edge> &list) {
+                for (; first != last; ++first) {
+                    Vertex source = (*first).first;
+                    if (source < 1)
+                        throw std::invalid_argument("compressedAdjacency: edge source "
+                                                    "outside [1, V]");
+                    if (source < u)
+                        throw std::invalid_argument("compressedAdjacency: edge stream is not "
+                                                    "grouped by source in increasing order");
+                    if (source != u)
+                        break;
+                    Edge e = toEdge((*first).second);
+                    if (e.first < 1 or e.first > V)
+                        throw std::invalid_argument("compressedAdjacency: edge target "
+                                                    "outside [1, V]");
+                    list.push_back(e);
+                }
+            });
+            // every list up to V is built, so anything left has source > V
+            if (first != last)
+                throw std::invalid_argument("compressedAdjacency: edge source outside [1, V]");
+        }
+
+        /**
+         * @brief Encodes the sorted list of vertex u and appends it to data.
+         *
+         * @param u The vertex whose list is encoded.
+         * @param list The neighbour list of u (sorted in place).
+         */
+        void appendList(Vertex u, std::vector<Edge> &list) {
+            std::sort(list.begin(), list.end());
+            Vertex prev = u;
+            bool first = true;
+            for (Edge e : list) {
+                if (first)
+                    encodeVarint(data, zigzagEncode(e.first - prev));
+                else
+                    encodeVarint(data, uint32_t(e.first - prev));
+                if (weighted)
+                    encodeVarint(data, zigzagEncode(e.second));
+                prev = e.first;
+                first = false;
+            }
+            edgeCount += list.size();
+        }
+
+    public:
+        using value_type = typename std::conditional<weighted, Edge, Vertex>::type;
+
+        /**
+         * @brief Forward iterator decoding one neighbour list on the fly.
+         * Dereferences by value to a Vertex, or to an Edge (vertex, weight)
+         * if weighted, so it works with range-for and <algorithm> alike.
+         *
+         */
+        class neighbourIterator {
+            const uint8_t *ptr = nullptr, *next = nullptr, *end = nullptr;
+            Vertex v, weight;
+            bool first;
+
+            void decode() {
+                if (ptr == end)
+                    return;
+                next = ptr;
+                uint32_t gap = decodeVarint(next);
+                v = (first ? v + zigzagDecode(gap) : v + Vertex(gap));
+                first = false;
+                if (weighted)
+                    weight = zigzagDecode(decodeVarint(next));
+            }
+
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = compressedAdjacency::value_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = value_type; // decoded, so returned by value
+
+                neighbourIterator() : v(0), weight(0), first(true) {}
+
+                neighbourIterator(const uint8_t *_ptr, const uint8_t *_end, Vertex u) :
+                    ptr(_ptr), next(_ptr), end(_end), v(u), weight(0), first(true) {
+                    decode();
+                }
+
+                value_type operator*() const {
+                    if constexpr (weighted)
+                        return Edge(v, weight);
+                    else
+                        return v;
+                }
+
+                neighbourIterator& operator++() {
+                    ptr = next;
+                    decode();
+                    return *this;
+                }
+
+                neighbourIterator operator++(int) {
+                    neighbourIterator old = *this;
+                    ++*this;
+                    return old;
+                }
+
+                bool operator==(const neighbourIterator &other) const { return ptr == other.ptr; }
+                bool operator!=(const neighbourIterator &other) const { return ptr != other.ptr; }
+        };
+
+        /**
+         * @brief Range over the neighbour list of one vertex, usable in a
+         * range based for loop in place of a std::vector.
+         *
+         */
+        struct neighbourRange {
+            neighbourIterator first, last;
+            neighbourIterator begin() const { return first; }
+            neighbourIterator end() const { return last; }
+        };
+
+        /**
+         * @brief Gets number of vertices
+         *
+         * @return Vertex Number of vertices
+         */
+        inline Vertex getV() const { return V; }
+
+        /**
+         * @brief Gets the neighbour list of u. Drop-in for the getAdj of
+         * Graph / weightedGraph, except that the neighbours come out sorted.
+         *
+         * @param u Vertex whose adjacency list is needed
+         * @return neighbourRange Range decoding the list of u.
+         */
+        inline neighbourRange getAdj(int u) const {
+            const uint8_t *first = start(u);
+            const uint8_t *last = start(u + 1);
+            return neighbourRange{neighbourIterator(first, last, u),
+                                  neighbourIterator(last, last, u)};
+        }
+
+        /**
+         * @brief Gets the number of stored edges. An undirected edge counts twice.
+         *
+         * @return size_t Number of edges.
+         */
+        inline size_t getEdgeCount() const { return edgeCount; }
+
+        /**
+         * @brief Gets the number of bytes used by the encoded lists and offsets.
+         *
+         * @return size_t Size in bytes.
+         */
+        inline size_t memoryUsage() const {
+            return data.capacity() + blockStart.capacity() * sizeof(uint64_t)
+                                   + offset.capacity() * sizeof(uint32_t);
+        }
+};
+
+class compressedGraph : public compressedAdjacency<false> {
+
+    public:
+
+        /**
+         * @brief Constructs a new compressed Graph object from a Graph object.
+         *
+         * @param G The Graph object to be compressed.
+         */
+        compressedGraph(const Graph &G) {
+            build(G.getV(), [&G](Vertex u, std::vector<Edge> &list) {
+                for (Vertex v : G.getAdj(u))
+                    list.push_back(Edge(v, 0));
+            });
+        }
+
+        /**
+         * @brief Constructs a new compressed Graph object list by list, without
+         * an uncompressed graph in memory.
+         *
+         * @param _V Number of vertices.
+         * @param listOf listOf(u, list) appends the neighbours of u to the
+         * empty std::vector<Vertex> list. Called for u = 0, 1, ..., V in order.
+         */
+        template <class ListFn, class = decltype(std::declval<ListFn&>()(
+                                    Vertex(), std::declval<std::vector<Vertex>&>()))>
+        compressedGraph(Vertex _V, ListFn listOf) {
+            std::vector<Vertex> neighbours;
+            build(_V, [&](Vertex u, std::vector<Edge> &list) {
+                neighbours.clear();
+                listOf(u, neighbours);
+                for (Vertex v : neighbours)
+                    list.push_back(Edge(v, 0));
+            });
+        }
+
+        /**
+         * @brief Constructs a new compressed Graph object from a single pass
+         * over a stream of directed edges (u, v) grouped by u in increasing
+         * order, e.g. std::istream_iterator over a file sorted by source. An
+         * undirected edge must appear in both directions.
+         *
+         * @param _V Number of vertices.
+         * @param first Input iterator to the first Edge (u, v).
+         * @param last Input iterator past the last edge.
+         * @throws std::invalid_argument if the stream is not grouped by u in
+         * increasing order or holds a vertex outside [1, V].
+         */
+        template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+        compressedGraph(Vertex _V, InputIt first, InputIt last) {
+            buildFromStream(_V, first, last, [](Vertex v) { return Edge(v, 0); });
+        }
+};
+
+class compressedWeightedGraph : public compressedAdjacency<true> {
+
+    public:
+
+        /**
+         * @brief Constructs a new compressed weighted Graph object from a
+         * weighted Graph object.
+         *
+         * @param G The weighted Graph object to be compressed.
+         */
+        compressedWeightedGraph(const weightedGraph &G) {
+            build(G.getV(), [&G](Vertex u, std::vector<Edge> &list) {
+                list = G.getAdj(u);
+            });
+        }
+
+        /**
+         * @brief Constructs a new compressed weighted Graph object list by
+         * list, without an uncompressed graph in memory.
+         *
+         * @param _V Number of vertices.
+         * @param listOf listOf(u, list) appends the edges of u to the empty
+         * std::vector<Edge> list, as Edge(v, weight). Called for
+         * u = 0, 1, ..., V in order.
+         */
+        template <class ListFn, class = decltype(std::declval<ListFn&>()(
+                                    Vertex(), std::declval<std::vector<Edge>&>()))>
+        compressedWeightedGraph(Vertex _V, ListFn listOf) {
+            build(_V, listOf);
+        }
+
+        /**
+         * @brief Constructs a new compressed weighted Graph object from a
+         * single pass over a stream of directed edges (u, Edge(v, weight))
+         * grouped by u in increasing order. An undirected edge must appear
+         * in both directions.
+         *
+         * @param _V Number of vertices.
+         * @param first Input iterator to the first std::pair<Vertex, Edge>.
+         * @param last Input iterator past the last edge.
+         * @throws std::invalid_argument if the stream is not grouped by u in
+         * increasing order or holds a vertex outside [1, V].
+         */
+        template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+        compressedWeightedGraph(Vertex _V, InputIt first, InputIt last) {
+            buildFromStream(_V, first, last, [](Edge e) { return e; });
+        }
+};
+
+#endif
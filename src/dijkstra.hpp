@@ -5,6 +5,50 @@
 
 #include "graph.hpp"
 
+/**
+ * @brief Finds the lengths of shortest paths from the source vertex to all 
+ * vertices of G. Works on any graph exposing getV() and getAdj(u) as a range
+ * of Edge, e.g. weightedGraph or compressedWeightedGraph.
+ * 
+ * @param G The graph.
+ * @param s The source vertex.
+ * @param d Array of size V + 1 in which the lengths are stored.
+ * @param p Array of size V + 1 in which the parent of every vertex on its 
+ * shortest path is stored. p[s] = -1.
+ * @param t Default = 0. If given, stops as soon as the shortest path to t is
+ * known; d[] and p[] are then only final for t and the vertices on its path.
+ */
+template <class GraphT>
+void
+dijkstraUtil(const GraphT &G, Vertex s, long long int *d, Vertex *p, Vertex t = 0) {
+    using ll = long long int;
+    using length = std::pair<ll, Vertex>;
+    std::priority_queue<length, std::vector<length>, std::greater<length>> pq;
+    memset(d, 0x3f, sizeof(ll) * (G.getV() + 1)); // initializing d[] to INF
+    d[s] = 0LL;
+    p[s] = -1;
+    pq.push(length(d[s], s));
+    while (not pq.empty()) {
+        Vertex u = pq.top().second;
+        ll dist = pq.top().first;
+        pq.pop();
+
+        if (dist > d[u])
+            continue;
+        if (u == t)
+            break;
+
+        for (Edge e : G.getAdj(u)) {
+            auto[v, len] = e;
+            if (len + d[u] < d[v]) {
+                d[v] = len + d[u];
+                p[v] = u;
+                pq.push(length(d[v], v));
+            }
+        }
+    }
+}
+
 struct Dijkstra : public weightedGraph {
     using ll = long long int;
     const ll INF = 0x3f3f3f3f3f3f3f3f;
@@ -59,30 +103,7 @@ struct Dijkstra : public weightedGraph {
      * @param s Default = 1. The source vertex.
      */
     void solveShortestPaths(Vertex s = 1) {
-        using length = std::pair<ll, Vertex>;
-        std::priority_queue<length, std::vector<length>, std::greater<length>> 
-                                                                            pq;
-        memset(d, 0x3f, sizeof(ll) * (V + 1)); // initializing d[] to INF
-        d[s] = 0LL;
-        p[s] = -1;
-        pq.push(length(d[s], s));
-        while (not pq.empty()) {
-            Vertex u = pq.top().second;
-            ll dist = pq.top().first;
-            pq.pop();
-
-            if (dist > d[u])
-                continue;
-
-            for (Edge e : adj[u]) {
-                auto[v, len] = e;
-                if (len + d[u] < d[v]) {
-                    d[v] = len + d[u];
-                    p[v] = u;
-                    pq.push(length(d[v], v));
-                }
-            }
-        }
+        dijkstraUtil(*this, s, d, p);
     }
 
     /**
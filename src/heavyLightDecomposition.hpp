@@ -0,0 +1,291 @@
+// heavyLightDecomposition.hpp
+
+#ifndef HEAVY_LIGHT_DECOMPOSITION_HPP
+#define HEAVY_LIGHT_DECOMPOSITION_HPP
+
+#include <functional>
+#include "graph.hpp"
+
+/**
+ * @brief Maximum of two values, for max edge and bottleneck path queries.
+ *
+ * @tparam T The value type. Use std::numeric_limits<T>::min() as identity.
+ */
+template <class T>
+struct MaxOp {
+    T operator()(const T &a, const T &b) const { return std::max(a, b); }
+};
+
+/**
+ * @brief Minimum of two values, for min edge path queries.
+ *
+ * @tparam T The value type. Use std::numeric_limits<T>::max() as identity.
+ */
+template <class T>
+struct MinOp {
+    T operator()(const T &a, const T &b) const { return std::min(a, b); }
+};
+
+/**
+ * @brief Heavy-light decomposition of a rooted tree with an iterative
+ * bottom-up segment tree over the decomposition order. Answers path and
+ * subtree aggregates in O(log^2 V) and point updates in O(log V).
+ *
+ * Values live either on vertices, or on edges, in which case the value of
+ * the edge (parent(v), v) is stored at v and the root holds identity.
+ *
+ * Vertices outside the component of the root hold no value: updates to them
+ * are ignored, queries involving them give identity and lca gives 0.
+ *
+ * @tparam T The value type.
+ * @tparam Op Associative and commutative binary operation on T, e.g.
+ * std::plus<T> for path sums or MaxOp<T> for bottleneck queries.
+ */
+template <class T, class Op = std::plus<T>>
+struct HeavyLightDecomposition {
+    int V, root, n; // n = number of vertices reached from the root
+    bool edgeValues;
+    T identity;
+    Op op;
+    std::vector<int> parent, depth, heavy, head, pos, subtreeSize;
+    std::vector<T> segTree;
+
+    /**
+     * @brief Constructs a new HeavyLightDecomposition object with values on
+     * the vertices. adj is laid out like the one taken by LCA.
+     *
+     * @param adj Adjacency list of the tree, 1-based.
+     * @param values values[u] is the value of vertex u, 1-based.
+     * @param _identity Identity element of op, e.g. 0 for sums.
+     * @param _root Default = 1. The root vertex.
+     */
+    HeavyLightDecomposition(const std::vector<std::vector<int>> &adj,
+                            const std::vector<T> &values, T _identity, int _root = 1) :
+        V(int(adj.size()) - 1), root(_root), edgeValues(false), identity(_identity) {
+
+        decompose([&adj](int u, auto visit) {
+            for (int v : adj[u])
+                visit(v);
+        });
+        build([&values](int u) { return values[u]; });
+    }
+
+    /**
+     * @brief Constructs a new HeavyLightDecomposition object with values on
+     * the edges, e.g. over the minimum spanning tree given by primUtil.
+     *
+     * @param tree Undirected weighted Graph object which is a tree (or forest;
+     * only the component of the root is decomposed).
+     * @param _identity Identity element of op, e.g. 0 for sums.
+     * @param _root Default = 1. The root vertex.
+     */
+    HeavyLightDecomposition(const weightedGraph &tree, T _identity, int _root = 1) :
+        V(tree.getV()), root(_root), edgeValues(true), identity(_identity) {
+
+        std::vector<T> weight(V + 1, identity);
+        decompose([&tree, &weight](int u, auto visit) {
+            for (Edge e : tree.getAdj(u)) {
+                if (visit(e.first))
+                    weight[e.first] = T(e.second);
+            }
+        });
+        build([&weight](int u) { return weight[u]; });
+    }
+
+    /**
+     * @brief Finds parent, depth, heavy child and chain head of every vertex,
+     * and numbers the vertices so that each chain and each subtree is a
+     * contiguous range. Iterative, so deep trees do not overflow the stack.
+     *
+     * @param forEach forEach(u, visit) calls visit(v) for every neighbour v
+     * of u. visit returns true if v is a child of u.
+     */
+    template <class ForEach>
+    void decompose(ForEach forEach) {
+        parent.assign(V + 1, 0);
+        depth.assign(V + 1, 0);
+        heavy.assign(V + 1, 0);
+        head.assign(V + 1, 0);
+        pos.assign(V + 1, -1);
+        subtreeSize.assign(V + 1, 1);
+
+        // BFS order: every parent comes before its children
+        std::vector<int> order;
+        order.reserve(V);
+        std::vector<bool> visited(V + 1);
+        visited[root] = true;
+        order.push_back(root);
+        for (size_t i = 0; i < order.size(); ++i) {
+            int u = order[i];
+            forEach(u, [&](int v) {
+                if (visited[v])
+                    return false;
+                visited[v] = true;
+                parent[v] = u;
+                depth[v] = depth[u] + 1;
+                order.push_back(v);
+                return true;
+            });
+        }
+
+        for (int i = int(order.size()) - 1; i > 0; --i) {
+            int v = order[i], u = parent[v];
+            subtreeSize[u] += subtreeSize[v];
+            if (heavy[u] == 0 or subtreeSize[v] > subtreeSize[heavy[u]])
+                heavy[u] = v;
+        }
+
+        // preorder visiting the heavy child first
+        int timer = 0;
+        std::vector<int> stack(1, root);
+        head[root] = root;
+        while (not stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            pos[u] = timer++;
+            forEach(u, [&](int v) {
+                if (parent[v] == u and v != heavy[u]) {
+                    head[v] = v;
+                    stack.push_back(v);
+                }
+                return false;
+            });
+            if (heavy[u] != 0) {
+                head[heavy[u]] = head[u];
+                stack.push_back(heavy[u]);
+            }
+        }
+        n = timer;
+    }
+
+    /**
+     * @brief Fills the segment tree, value(u) going to position pos[u].
+     *
+     * @param value value(u) is the initial value of u.
+     */
+    template <class Value>
+    void build(Value value) {
+        segTree.assign(2 * std::max(n, 1), identity);
+        for (int u = 1; u <= V; ++u) {
+            if (pos[u] >= 0)
+                segTree[n + pos[u]] = (u == root and edgeValues ? identity : value(u));
+        }
+        for (int i = n - 1; i >= 1; --i)
+            segTree[i] = op(segTree[i << 1], segTree[i << 1 | 1]);
+    }
+
+    /**
+     * @brief Aggregate over positions [l, r) of the segment tree.
+     *
+     */
+    T query(int l, int r) const {
+        T res = identity;
+        for (l += n, r += n; l < r; l >>= 1, r >>= 1) {
+            if (l & 1)
+                res = op(res, segTree[l++]);
+            if (r & 1)
+                res = op(res, segTree[--r]);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Sets the value of vertex u. With values on the edges, this is
+     * the value of the edge from u to its parent.
+     *
+     * @param u The vertex.
+     * @param value The new value.
+     */
+    void update(int u, T value) {
+        if (pos[u] < 0)
+            return;
+        int i = pos[u] + n;
+        segTree[i] = value;
+        for (i >>= 1; i >= 1; i >>= 1)
+            segTree[i] = op(segTree[i << 1], segTree[i << 1 | 1]);
+    }
+
+    /**
+     * @brief Sets the value of the tree edge between u and v.
+     *
+     * @param u One end of the edge.
+     * @param v The other end of the edge.
+     * @param value The new value.
+     */
+    void updateEdge(int u, int v, T value) {
+        update(depth[u] > depth[v] ? u : v, value);
+    }
+
+    /**
+     * @brief Finds the lowest common ancestor of u and v by climbing chains.
+     * Takes O(log V).
+     *
+     * @param u A vertex of the tree.
+     * @param v A vertex of the tree.
+     * @return int The lowest common ancestor, 0 if u or v is not in the
+     * component of the root.
+     */
+    int lca(int u, int v) const {
+        if (pos[u] < 0 or pos[v] < 0)
+            return 0;
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]])
+                std::swap(u, v);
+            u = parent[head[u]];
+        }
+        return (depth[u] < depth[v] ? u : v);
+    }
+
+    /**
+     * @brief Aggregate of the values on the path between u and v. With
+     * values on the edges, the vertex u = v path gives identity.
+     *
+     * @param u One end of the path.
+     * @param v The other end of the path.
+     * @return T The aggregate.
+     */
+    T pathQuery(int u, int v) const {
+        T res = identity;
+        if (pos[u] < 0 or pos[v] < 0)
+            return res;
+        while (head[u] != head[v]) {
+            if (depth[head[u]] < depth[head[v]])
+                std::swap(u, v);
+            res = op(res, query(pos[head[u]], pos[u] + 1));
+            u = parent[head[u]];
+        }
+        if (depth[u] > depth[v])
+            std::swap(u, v);
+        // with values on the edges, the lca u holds the edge above the path
+        return op(res, query(pos[u] + edgeValues, pos[v] + 1));
+    }
+
+    /**
+     * @brief Aggregate of the values in the subtree of u. With values on the
+     * edges, only the edges below u are counted.
+     *
+     * @param u The root of the subtree.
+     * @return T The aggregate.
+     */
+    T subtreeQuery(int u) const {
+        if (pos[u] < 0)
+            return identity;
+        return query(pos[u] + edgeValues, pos[u] + subtreeSize[u]);
+    }
+
+    /**
+     * @brief Answers a batch of path queries.
+     *
+     * @param queries Container of (u, v) pairs.
+     * @return std::vector<T> pathQuery(u, v) for each pair, in order.
+     */
+    std::vector<T> pathQueries(const std::vector<std::pair<int, int>> &queries) const {
+        std::vector<T> res;
+        res.reserve(queries.size());
+        for (auto [u, v] : queries)
+            res.push_back(pathQuery(u, v));
+        return res;
+    }
+};
+
+#endif
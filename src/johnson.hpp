@@ -0,0 +1,218 @@
+// johnson.hpp
+
+#ifndef JOHNSON_HPP
+#define JOHNSON_HPP
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "graph.hpp"
+
+/**
+ * @brief Result of an all pairs shortest path computation.
+ * d[u][v] = INF if v is unreachable from u. d is left empty if the graph has
+ * a negative cycle or if the rows were streamed to a callback.
+ */
+struct JohnsonResult {
+    bool negativeCycle;
+    std::vector<std::vector<long long int>> d;
+};
+
+struct Johnson : public weightedGraph {
+    using ll = long long int;
+    const ll INF = 0x3f3f3f3f3f3f3f3f;
+
+    /**
+     * Vertex potentials found by Bellman-Ford (SPFA). Edge weight w(u, v) is
+     * reweighted to w(u, v) + h[u] - h[v], which is never negative.
+     *
+     */
+    std::vector<ll> h;
+
+    /**
+     * @brief Constructs a new Johnson object.
+     *
+     * @param _V Number of vertices.
+     * @param _directed Default = false. specify true if graph is directed.
+     */
+    Johnson(Vertex _V, bool _directed = false) : weightedGraph(_V, _directed) {}
+
+    /**
+     * @brief Constructs a new Johnson object from a weighted Graph object.
+     *
+     * @param G The weighted Graph Object to be copied.
+     */
+    Johnson(const weightedGraph &G) : weightedGraph(G) {}
+
+    /**
+     * @brief Constructs a new Johnson object from an old one.
+     * It calls the weightedGraph copy constructor.
+     *
+     * @param copy The old Johnson object to be copied.
+     */
+    Johnson(const Johnson &copy) : weightedGraph(copy), h(copy.h) {}
+
+    /**
+     * @brief Computes the potentials Johnson::h[] with SPFA from a virtual
+     * source joined to every vertex by a 0 weight edge.
+     *
+     * @return true Returns true if the graph has a negative cycle.
+     * @return false Returns false otherwise.
+     */
+    bool reweight() {
+        h.assign(V + 1, 0LL);
+        // number of edges on the current path from the virtual source
+        std::vector<Vertex> len(V + 1, 1);
+        std::vector<bool> inQueue(V + 1, true);
+        std::queue<Vertex> Q;
+        for (Vertex u = 1; u <= V; ++u)
+            Q.push(u);
+
+        while (not Q.empty()) {
+            Vertex u = Q.front();
+            Q.pop();
+            inQueue[u] = false;
+            for (Edge e : adj[u]) {
+                auto[v, w] = e;
+                if (h[u] + w < h[v]) {
+                    h[v] = h[u] + w;
+                    len[v] = len[u] + 1;
+                    // a simple path has at most V edges (V + 1 vertices)
+                    if (len[v] > V)
+                        return true;
+                    if (not inQueue[v]) {
+                        inQueue[v] = true;
+                        Q.push(v);
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Runs Dijkstra on the reweighted graph from source s and stores the
+     * real shortest path lengths in row. Only reads the graph and Johnson::h[],
+     * so several sources may be solved concurrently. Johnson::reweight() must
+     * have been called before.
+     *
+     * @param s The source vertex.
+     * @param row Output, resized to V + 1. row[v] = INF if v is unreachable.
+     */
+    void shortestPathsFrom(Vertex s, std::vector<ll> &row) const {
+        using length = std::pair<ll, Vertex>;
+        std::priority_queue<length, std::vector<length>, std::greater<length>>
+                                                                            pq;
+        row.assign(V + 1, INF);
+        row[s] = 0LL;
+        pq.push(length(0LL, s));
+        while (not pq.empty()) {
+            auto[dist, u] = pq.top();
+            pq.pop();
+
+            if (dist > row[u])
+                continue;
+
+            for (Edge e : adj[u]) {
+                auto[v, w] = e;
+                ll len = w + h[u] - h[v];
+                if (dist + len < row[v]) {
+                    row[v] = dist + len;
+                    pq.push(length(row[v], v));
+                }
+            }
+        }
+
+        // undo the reweighting
+        for (Vertex v = 1; v <= V; ++v) {
+            if (row[v] != INF)
+                row[v] += h[v] - h[s];
+        }
+    }
+
+    /**
+     * @brief Finds the lengths of shortest paths between all pair of vertices
+     * and passes them row by row to onRow, so the whole V x V matrix is never
+     * stored. Rows are solved by up to `threads` workers sharing this graph,
+     * and arrive in no particular order when threads > 1. onRow is never
+     * called concurrently.
+     *
+     * @param onRow Callback void(Vertex s, const std::vector<ll> &row), where
+     * row[v] is the length of the shortest path from s to v.
+     * @param threads Default = 1. Number of workers, 0 uses all hardware threads.
+     * @return JohnsonResult negativeCycle is set if the graph has a negative
+     * cycle, in which case onRow is never called. d is left empty.
+     * @throws The first exception thrown by onRow, after all workers stopped.
+     */
+    JohnsonResult
+    solveAllPairs(const std::function<void(Vertex, const std::vector<ll>&)> &onRow,
+                  unsigned threads = 1) {
+        if (reweight())
+            return JohnsonResult{true, {}};
+
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min<unsigned>(threads, std::max(V, 1));
+
+        std::atomic<Vertex> next(1);
+        std::mutex outputLock;
+        // first exception thrown by any worker, rethrown once all are joined
+        std::exception_ptr error;
+        auto fail = [&]() {
+            std::lock_guard<std::mutex> guard(outputLock);
+            if (not error)
+                error = std::current_exception();
+            next = V + 1; // the other workers stop after their current row
+        };
+        auto worker = [&]() {
+            try {
+                std::vector<ll> row;
+                for (Vertex s = next++; s <= V; s = next++) {
+                    shortestPathsFrom(s, row);
+                    std::lock_guard<std::mutex> guard(outputLock);
+                    if (error)
+                        return;
+                    onRow(s, row);
+                }
+            } catch (...) {
+                fail();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        try {
+            for (unsigned i = 1; i < threads; ++i)
+                pool.emplace_back(worker);
+        } catch (...) {
+            fail();
+        }
+        worker();
+        for (std::thread &t : pool)
+            t.join();
+        if (error)
+            std::rethrow_exception(error);
+        return JohnsonResult{false, {}};
+    }
+
+    /**
+     * @brief Finds the lengths of shortest paths between all pair of vertices
+     * using Johnson's algorithm. Takes O(VE log V) time, which beats
+     * floydWarshall on sparse graphs.
+     *
+     * @param threads Default = 1. Number of workers, 0 uses all hardware threads.
+     * @return JohnsonResult d[u][v] is the length of the shortest path from
+     * u to v, unless negativeCycle is set.
+     */
+    JohnsonResult solveAllPairs(unsigned threads = 1) {
+        std::vector<std::vector<ll>> d(V + 1);
+        JohnsonResult result = solveAllPairs(
+            [&d](Vertex s, const std::vector<ll> &row) { d[s] = row; }, threads);
+        if (not result.negativeCycle)
+            result.d = std::move(d);
+        return result;
+    }
+};
+
+#endif
@@ -32,11 +32,11 @@ struct LCA {
         tout[u] = ++timer;
     }
 
-    bool isAncestor(int u, int v) {
+    bool isAncestor(int u, int v) const {
         return (tin[u] <= tin[v] and tout[u] >= tout[v]);
     }
     
-    int lca(int u, int v)
+    int lca(int u, int v) const
     {
         if (isAncestor(u, v))
             return u;
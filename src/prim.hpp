@@ -5,6 +5,56 @@
 
 #include "graph.hpp"
 
+/**
+ * @brief Solves the problem of minimum spanning tree using Prim's 
+ * algorithm. Works on any graph exposing getV() and getAdj(u) as a range
+ * of Edge, and only reads it.
+ * 
+ * @param G The graph.
+ * @param tree Default = nullptr. If given, the edges of the minimum spanning
+ * tree are added to it, e.g. to run HeavyLightDecomposition over them.
+ * @return long long int The sum of all the weights in the minimum spanning tree. 
+ */
+template <class GraphT>
+long long int
+primUtil(const GraphT &G, weightedGraph *tree = nullptr) {
+    Vertex V = G.getV();
+    long long int sumMST = 0LL;
+    int weightCount = 0;
+    std::vector<bool> visited(V + 1);
+    using Candidate = std::pair<Edge, Vertex>;
+    std::priority_queue<Candidate, std::vector<Candidate>, 
+                                std::greater<Candidate>> pQ;
+
+    // first.first - Edge weight.
+    // first.second - Vertex. 
+    // second - Vertex the edge comes from.
+    pQ.push(Candidate(Edge(0, 1), 0));
+
+    while (not pQ.empty()) {
+        auto[E, from] = pQ.top();
+        pQ.pop();
+        Vertex u = E.second;
+        if (visited[u])
+            continue;
+        visited[u] = true;
+        sumMST += 1LL * E.first;
+        if (tree != nullptr and from != 0)
+            tree->addEdge(from, u, E.first);
+        weightCount++;
+        if (weightCount == V) 
+            break;
+        for (Edge e : G.getAdj(u)) {
+            int v = e.first;
+            if (visited[v])
+                continue;
+            pQ.push(Candidate(Edge(e.second, v), u));
+        }
+    }
+
+    return sumMST;
+}
+
 struct Prim : public weightedGraph {
     const long long int INF = 0x3f3f3f3f3f3f3f3f;
 
@@ -39,36 +89,7 @@ struct Prim : public weightedGraph {
      * @return ll The sum of all the weights in the minimum spanning tree. 
      */
     long long int PrimMST() {
-        long long int sumMST = 0LL;
-        int weightCount = 0;
-        std::vector<bool> visited(V + 1);
-        std::priority_queue<Edge, std::vector<Edge>, 
-                                    std::greater<Edge>> pQ;
-
-        // first - Edge weight.
-        // second - Vertex. 
-        pQ.push(Edge(0, 1));
-
-        while (not pQ.empty()) {
-            Edge E = pQ.top();
-            pQ.pop();
-            Vertex u = E.second;
-            if (visited[u])
-                continue;
-            visited[u] = true;
-            sumMST += 1LL * E.first;
-            weightCount++;
-            if (weightCount == V) 
-                break;
-            for (Edge e : adj[u]) {
-                int v = e.first;
-                if (visited[v])
-                    continue;
-                pQ.push(Edge(e.second, v));
-            }
-        }
-
-        return sumMST;
+        return primUtil(*this);
     }
 };
 
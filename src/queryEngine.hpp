@@ -0,0 +1,299 @@
+// queryEngine.hpp
+
+#ifndef QUERY_ENGINE_HPP
+#define QUERY_ENGINE_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "dijkstra.hpp"
+#include "prim.hpp"
+
+/**
+ * @brief Per-thread mutable state of a QueryEngine worker. Each worker owns
+ * one and reuses it for every query it runs.
+ */
+struct QueryScratch {
+    std::vector<long long int> d;
+    std::vector<Vertex> p;
+
+    QueryScratch(Vertex V) : d(V + 1), p(V + 1) {}
+};
+
+/**
+ * @brief Answers queries asynchronously on a pool of worker threads sharing a
+ * single immutable graph. The graph is never copied per thread; only the
+ * QueryScratch arrays (2 x V) are.
+ *
+ * @tparam GraphT weightedGraph, compressedWeightedGraph, or any graph exposing
+ * getV() and getAdj(u) as a range of Edge.
+ */
+template <class GraphT = weightedGraph>
+struct QueryEngine {
+    using ll = long long int;
+    using Task = std::function<void(QueryScratch&)>;
+    const ll INF = 0x3f3f3f3f3f3f3f3f;
+
+    /**
+     * @brief Constructs a new QueryEngine object and starts its workers.
+     *
+     * @param _G The graph to be queried. It must not be modified afterwards.
+     * @param threads Default = 0. Number of workers, 0 uses all hardware threads.
+     * @param _batchSize Default = 16. Maximum number of queries a worker takes
+     * from the queue at once.
+     * @throws std::system_error if a worker cannot be started, after the
+     * workers already started are stopped.
+     */
+    QueryEngine(std::shared_ptr<const GraphT> _G, unsigned threads = 0,
+                size_t _batchSize = 16) :
+        G(std::move(_G)), batchSize(std::max<size_t>(_batchSize, 1)), stopping(false) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        try {
+            for (unsigned i = 0; i < threads; ++i)
+                workers.emplace_back(&QueryEngine::workerLoop, this);
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Constructs a new QueryEngine object from a copy of G.
+     *
+     * @param _G The graph to be copied once.
+     * @param threads Default = 0. Number of workers, 0 uses all hardware threads.
+     * @param _batchSize Default = 16. Maximum number of queries a worker takes
+     * from the queue at once.
+     */
+    QueryEngine(const GraphT &_G, unsigned threads = 0, size_t _batchSize = 16) :
+        QueryEngine(std::make_shared<const GraphT>(_G), threads, _batchSize) {}
+
+    QueryEngine(const QueryEngine &) = delete;
+    QueryEngine& operator=(const QueryEngine &) = delete;
+
+    /**
+     * @brief Destroys the QueryEngine object. Queries already submitted are
+     * answered before the workers stop.
+     *
+     */
+    ~QueryEngine() {
+        stop();
+    }
+
+    /**
+     * @brief Gets the shared graph.
+     *
+     * @return const GraphT& Const reference to the graph.
+     */
+    inline const GraphT& getGraph() const { return *G; }
+
+    /**
+     * @brief Runs f(G, scratch) on a worker. f must only read G. Other read-only
+     * structures built once may be captured by f and shared the same way.
+     *
+     * @param f The query, callable as f(const GraphT &, QueryScratch &).
+     * @return std::future The result of f.
+     */
+    template <class F>
+    auto submit(F f) -> std::future<decltype(f(std::declval<const GraphT&>(),
+                                                std::declval<QueryScratch&>()))> {
+        using R = decltype(f(std::declval<const GraphT&>(), std::declval<QueryScratch&>()));
+        auto task = std::make_shared<std::packaged_task<R(QueryScratch&)>>(
+            [this, f](QueryScratch &scratch) { return f(*G, scratch); });
+        std::future<R> result = task->get_future();
+        push([task](QueryScratch &scratch) { (*task)(scratch); });
+        return result;
+    }
+
+    /**
+     * @brief Length of the shortest path from s to t. Edge weights must not be
+     * negative.
+     *
+     * @param s The source vertex.
+     * @param t The destination vertex.
+     * @return std::future<ll> The length, INF if t is unreachable from s.
+     */
+    std::future<ll> distance(Vertex s, Vertex t) {
+        return submit([s, t](const GraphT &G, QueryScratch &scratch) {
+            dijkstraUtil(G, s, scratch.d.data(), scratch.p.data(), t);
+            return scratch.d[t];
+        });
+    }
+
+    /**
+     * @brief A shortest path from s to t. Edge weights must not be negative.
+     *
+     * @param s The source vertex.
+     * @param t The destination vertex.
+     * @return std::future<std::vector<Vertex>> The vertices on the path from s
+     * to t, empty if t is unreachable from s.
+     */
+    std::future<std::vector<Vertex>> path(Vertex s, Vertex t) {
+        const ll inf = INF;
+        return submit([s, t, inf](const GraphT &G, QueryScratch &scratch) {
+            std::vector<Vertex> path;
+            dijkstraUtil(G, s, scratch.d.data(), scratch.p.data(), t);
+            if (scratch.d[t] >= inf)
+                return path;
+            for (Vertex u = t; u != s; u = scratch.p[u])
+                path.push_back(u);
+            path.push_back(s);
+            std::reverse(path.begin(), path.end());
+            return path;
+        });
+    }
+
+    /**
+     * @brief Sum of the weights in the minimum spanning tree, found by Prim's
+     * algorithm.
+     *
+     * @return std::future<ll> The weight of the minimum spanning tree.
+     */
+    std::future<ll> mstWeight() {
+        return submit([](const GraphT &G, QueryScratch &) { return primUtil(G); });
+    }
+
+    /**
+     * @brief Shares a read-only LCA structure with the workers. It must be
+     * attached before the lca queries using it are submitted.
+     *
+     * @param tree An LCA from lcaBinaryLift.cpp, or any type with a const
+     * int lca(int u, int v) method, e.g. HeavyLightDecomposition.
+     */
+    template <class LCAT>
+    void attachLCA(std::shared_ptr<const LCAT> tree) {
+        lcaOf = [tree](int u, int v) { return tree->lca(u, v); };
+    }
+
+    /**
+     * @brief Lowest common ancestor of u and v in the attached tree.
+     *
+     * @param u A vertex of the tree.
+     * @param v A vertex of the tree.
+     * @return std::future<int> The lowest common ancestor. Holds a
+     * std::logic_error if no tree was attached.
+     */
+    std::future<int> lca(int u, int v) {
+        return submit([u, v, lcaOf = lcaOf](const GraphT &, QueryScratch &) {
+            if (not lcaOf)
+                throw std::logic_error("QueryEngine::lca: no LCA attached");
+            return lcaOf(u, v);
+        });
+    }
+
+    /**
+     * @brief Answers a batch of distance queries. Queries sharing a source are
+     * answered by a single Dijkstra run, and the distinct sources are spread
+     * over the workers.
+     *
+     * @param queries Container of (s, t) pairs.
+     * @return std::vector<std::future<ll>> The lengths, in the order of queries.
+     */
+    std::vector<std::future<ll>>
+    distances(const std::vector<std::pair<Vertex, Vertex>> &queries) {
+        using Group = std::vector<std::pair<Vertex, std::promise<ll>>>;
+        std::vector<size_t> order(queries.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return queries[a].first < queries[b].first;
+        });
+
+        std::vector<std::future<ll>> results(queries.size());
+        std::vector<Task> batch;
+        for (size_t i = 0; i < order.size(); ) {
+            Vertex s = queries[order[i]].first;
+            auto group = std::make_shared<Group>();
+            for (; i < order.size() and queries[order[i]].first == s; ++i) {
+                group->emplace_back(queries[order[i]].second, std::promise<ll>());
+                results[order[i]] = group->back().second.get_future();
+            }
+            batch.push_back([this, s, group](QueryScratch &scratch) {
+                Vertex t = (group->size() == 1 ? group->front().first : 0);
+                try {
+                    dijkstraUtil(*G, s, scratch.d.data(), scratch.p.data(), t);
+                } catch (...) {
+                    // fail every query of the group, as submit() would
+                    for (auto &query : *group)
+                        query.second.set_exception(std::current_exception());
+                    return;
+                }
+                for (auto &query : *group)
+                    query.second.set_value(scratch.d[query.first]);
+            });
+        }
+        push(std::move(batch));
+        return results;
+    }
+
+    private:
+        std::shared_ptr<const GraphT> G;
+        std::function<int(int, int)> lcaOf;
+        size_t batchSize;
+        bool stopping;
+        std::queue<Task> tasks;
+        std::mutex queueLock;
+        std::condition_variable ready;
+        std::vector<std::thread> workers;
+
+        /**
+         * @brief Lets the workers drain the queue, then joins them.
+         *
+         */
+        void stop() {
+            {
+                std::lock_guard<std::mutex> guard(queueLock);
+                stopping = true;
+            }
+            ready.notify_all();
+            for (std::thread &t : workers)
+                t.join();
+        }
+
+        void push(Task task) {
+            {
+                std::lock_guard<std::mutex> guard(queueLock);
+                tasks.push(std::move(task));
+            }
+            ready.notify_one();
+        }
+
+        void push(std::vector<Task> batch) {
+            {
+                std::lock_guard<std::mutex> guard(queueLock);
+                for (Task &task : batch)
+                    tasks.push(std::move(task));
+            }
+            ready.notify_all();
+        }
+
+        void workerLoop() {
+            QueryScratch scratch(G->getV());
+            std::vector<Task> batch;
+            batch.reserve(batchSize);
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(queueLock);
+                    ready.wait(lock, [this]() { return stopping or not tasks.empty(); });
+                    if (tasks.empty())
+                        return;
+                    // leave work for the other workers when the queue is short
+                    size_t take = std::min(batchSize, tasks.size() / workers.size() + 1);
+                    while (not tasks.empty() and batch.size() < take) {
+                        batch.push_back(std::move(tasks.front()));
+                        tasks.pop();
+                    }
+                }
+                for (Task &task : batch)
+                    task(scratch);
+                batch.clear();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,90 @@
+// queryServer.cpp
+
+#include <string>
+#include "queryEngine.hpp"
+#include "lcaBinaryLift.cpp"
+
+/**
+ * @brief Loopback driver for QueryEngine. Reads a weighted graph and a list
+ * of queries from stdin and prints one answer per query, in input order.
+ *
+ * Input:
+ *     V E directed threads
+ *     E lines "u v w"
+ *     then queries until end of input, one per line:
+ *         d s t   length of the shortest path from s to t (-1 if unreachable)
+ *         p s t   vertices on a shortest path from s to t (-1 if unreachable)
+ *         m       weight of the minimum spanning tree
+ *         l u v   lowest common ancestor of u and v in the minimum spanning
+ *                 tree rooted at 1 (the graph must be connected)
+ *
+ * All distance queries are sent to the engine as a single batch.
+ */
+int main() {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    int V, E, directed;
+    unsigned threads;
+    std::cin >> V >> E >> directed >> threads;
+    auto G = std::make_shared<weightedGraph>(V, bool(directed));
+    for (int i = 0; i < E; ++i) {
+        Vertex u, v, w;
+        std::cin >> u >> v >> w;
+        G->addEdge(u, v, w);
+    }
+
+    QueryEngine<weightedGraph> engine(std::shared_ptr<const weightedGraph>(G), threads);
+
+    // LCA over the minimum spanning tree, shared read-only by the workers
+    weightedGraph mst(V);
+    primUtil(*G, &mst);
+    std::vector<std::vector<int>> treeAdj(V + 1);
+    for (Vertex u = 1; u <= V; ++u) {
+        for (Edge e : mst.getAdj(u))
+            treeAdj[u].push_back(e.first);
+    }
+    engine.attachLCA(std::make_shared<const LCA>(treeAdj, V));
+
+    std::vector<char> type;
+    std::vector<std::pair<Vertex, Vertex>> distanceQueries;
+    std::vector<std::future<std::vector<Vertex>>> paths;
+    std::vector<std::future<long long int>> msts;
+    std::vector<std::future<int>> lcas;
+    std::string q;
+    while (std::cin >> q) {
+        type.push_back(q[0]);
+        if (q[0] == 'm') {
+            msts.push_back(engine.mstWeight());
+            continue;
+        }
+        Vertex s, t;
+        std::cin >> s >> t;
+        if (q[0] == 'd')
+            distanceQueries.push_back(std::make_pair(s, t));
+        else if (q[0] == 'l')
+            lcas.push_back(engine.lca(s, t));
+        else
+            paths.push_back(engine.path(s, t));
+    }
+    auto distances = engine.distances(distanceQueries);
+
+    size_t nextDistance = 0, nextPath = 0, nextMST = 0, nextLCA = 0;
+    for (char c : type) {
+        if (c == 'd') {
+            long long int d = distances[nextDistance++].get();
+            std::cout << (d >= engine.INF ? -1 : d) << "\n";
+        } else if (c == 'p') {
+            std::vector<Vertex> path = paths[nextPath++].get();
+            if (path.empty())
+                std::cout << -1;
+            for (Vertex u : path)
+                std::cout << u << ' ';
+            std::cout << "\n";
+        } else if (c == 'l') {
+            std::cout << lcas[nextLCA++].get() << "\n";
+        } else {
+            std::cout << msts[nextMST++].get() << "\n";
+        }
+    }
+}
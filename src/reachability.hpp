@@ -0,0 +1,317 @@
+// reachability.hpp
+
+#ifndef REACHABILITY_HPP
+#define REACHABILITY_HPP
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "graph.hpp"
+
+/**
+ * @brief Checks that order is a topological ordering of G and returns the
+ * position of every vertex in it. Takes O(V + E).
+ *
+ * @param G The Graph object, or any graph exposing getV() and getAdj(u).
+ * @param order The ordering to check, e.g. from topologicalOrder, which is
+ * empty when G has a cycle.
+ * @return std::vector<Vertex> rank[u] = position of u in order.
+ * @throws std::invalid_argument if order is not a topological ordering of G.
+ */
+template <class GraphT>
+std::vector<Vertex>
+topologicalRank(const GraphT &G, const std::vector<Vertex> &order) {
+    Vertex V = G.getV();
+    if (Vertex(order.size()) != V)
+        throw std::invalid_argument("order is not a topological ordering: "
+                                    "wrong size (is the graph cyclic?)");
+    std::vector<Vertex> rank(V + 1, -1);
+    for (Vertex i = 0; i < V; ++i) {
+        Vertex u = order[i];
+        if (u < 1 or u > V or rank[u] != -1)
+            throw std::invalid_argument("order is not a permutation of the vertices");
+        rank[u] = i;
+    }
+    for (Vertex u = 1; u <= V; ++u) {
+        for (Vertex v : G.getAdj(u)) {
+            if (rank[v] <= rank[u])
+                throw std::invalid_argument("order is not a topological ordering: "
+                                            "an edge goes backwards");
+        }
+    }
+    return rank;
+}
+
+/**
+ * @brief Transitive closure of a DAG stored as one bitset row per vertex.
+ * Takes O(V^2 / 8) bytes, so it suits DAGs of up to about 10^5 vertices;
+ * use GrailReachability beyond that. Queries are O(1).
+ */
+struct BitsetReachability {
+    /**
+     * 256 bit block of a row. A GCC vector extension, so an OR of two blocks
+     * is one AVX instruction (two SSE ones without -mavx) at any -O level.
+     *
+     */
+    typedef uint64_t Block __attribute__((vector_size(32)));
+
+    Vertex V;
+    size_t blocks; // Blocks per row
+    std::vector<Block> closure;
+
+    /**
+     * @brief Constructs a new BitsetReachability object. Rows are filled in
+     * reverse topological order, row[u] being the OR of the rows of the
+     * children of u.
+     *
+     * @param G The Graph object, or any graph exposing getV() and getAdj(u).
+     * @param order A topological ordering of G, e.g. from topologicalOrder.
+     * @throws std::invalid_argument if order is not a topological ordering of G.
+     */
+    template <class GraphT>
+    BitsetReachability(const GraphT &G, const std::vector<Vertex> &order) :
+        V(G.getV()),
+        blocks((V >> 8) + 1),
+        closure((V + 1) * blocks) {
+
+        std::vector<Vertex> rank = topologicalRank(G, order);
+
+        std::vector<Vertex> children;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            Vertex u = *it;
+            Block *row = &closure[u * blocks];
+            row[u >> 8][(u >> 6) & 3] |= 1ULL << (u & 63);
+
+            // visiting the children in topological order lets us skip those
+            // already reached through an earlier child
+            children.clear();
+            for (Vertex v : G.getAdj(u))
+                children.push_back(v);
+            std::sort(children.begin(), children.end(), [&rank](Vertex a, Vertex b) {
+                return rank[a] < rank[b];
+            });
+            for (Vertex v : children) {
+                if (reachable(u, v))
+                    continue;
+                const Block *other = &closure[v * blocks];
+                for (size_t i = 0; i < blocks; ++i)
+                    row[i] |= other[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Checks if there is a path from u to v.
+     *
+     * @param u The start vertex.
+     * @param v The destination vertex.
+     * @return true Returns true if v is reachable from u (always when u = v).
+     * @return false Returns false otherwise.
+     */
+    inline bool reachable(Vertex u, Vertex v) const {
+        return closure[u * blocks + (v >> 8)][(v >> 6) & 3] >> (v & 63) & 1;
+    }
+};
+
+/**
+ * @brief Per-thread search state of GrailReachability::reachable. Each
+ * thread querying the same index owns one.
+ */
+struct GrailScratch {
+    std::vector<unsigned> stamp;
+    unsigned epoch;
+    std::vector<Vertex> stack;
+
+    GrailScratch(Vertex V) : stamp(V + 1), epoch(0) {}
+};
+
+/**
+ * @brief GRAIL reachability index for large DAGs. Every vertex gets k
+ * interval labels [low, post] from k randomized DFS traversals; if u reaches
+ * v, the label of v nests in the label of u for every traversal. Memory is
+ * O(kV + E).
+ *
+ * A query is answered in O(k) when the labels or topological ranks rule the
+ * pair out, or when v lies in the DFS tree of u in some traversal (tree
+ * cover). Otherwise it falls back to a DFS pruned by the same tests.
+ * Queries only read the index, so any number of threads may run them, each
+ * with its own GrailScratch.
+ */
+struct GrailReachability {
+    Vertex V;
+    int k;
+    std::vector<Vertex> rank;
+    std::vector<size_t> offset;
+    std::vector<Vertex> target;
+
+    /**
+     * label[(u * k + i) * 3 + j] for traversal i holds, for j = 0, 1, 2, the
+     * low, post and treeLow of u. v is in the DFS tree of u iff
+     * treeLow[u] <= post[v] <= post[u].
+     *
+     */
+    std::vector<Vertex> label;
+
+    /**
+     * @brief Constructs a new GrailReachability object.
+     *
+     * @param G The Graph object, or any graph exposing getV() and getAdj(u).
+     * @param order A topological ordering of G, e.g. from topologicalOrder.
+     * @param _k Default = 3. Number of traversals.
+     * @param seed Default = 1. Seed of the traversal orders.
+     * @throws std::invalid_argument if order is not a topological ordering of G.
+     */
+    template <class GraphT>
+    GrailReachability(const GraphT &G, const std::vector<Vertex> &order,
+                      int _k = 3, unsigned seed = 1) :
+        V(G.getV()),
+        k(std::max(_k, 1)),
+        rank(topologicalRank(G, order)),
+        offset(V + 2),
+        label(size_t(V + 1) * k * 3) {
+
+        // private copy of the edges (CSR), read by the traversals and queries
+        for (Vertex u = 1; u <= V; ++u) {
+            for (Vertex v : G.getAdj(u))
+                target.push_back(v);
+            offset[u + 1] = target.size();
+        }
+
+        std::mt19937 rng(seed);
+        std::vector<Vertex> roots(order);
+        for (int i = 0; i < k; ++i) {
+            if (i > 0)
+                std::shuffle(roots.begin(), roots.end(), rng);
+            labelTraversal(i, roots, i == 0 ? 0 : rng());
+
+            // low[u] = min(post[u], low of every child), children first
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                Vertex u = *it;
+                Vertex &low = label[(size_t(u) * k + i) * 3];
+                for (size_t j = offset[u]; j < offset[u + 1]; ++j)
+                    low = std::min(low, label[(size_t(target[j]) * k + i) * 3]);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks if there is a path from u to v.
+     *
+     * @param u The start vertex.
+     * @param v The destination vertex.
+     * @param scratch Search state of the calling thread, built with V.
+     * @return true Returns true if v is reachable from u (always when u = v).
+     * @return false Returns false otherwise.
+     */
+    bool reachable(Vertex u, Vertex v, GrailScratch &scratch) const {
+        if (u == v)
+            return true;
+        if (not mayReach(u, v))
+            return false;
+        if (inTree(u, v))
+            return true;
+
+        // DFS from u, pruned by the labels
+        std::vector<unsigned> &stamp = scratch.stamp;
+        std::vector<Vertex> &stack = scratch.stack;
+        unsigned epoch = ++scratch.epoch;
+        if (epoch == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = scratch.epoch = 1;
+        }
+        stack.assign(1, u);
+        stamp[u] = epoch;
+        while (not stack.empty()) {
+            Vertex w = stack.back();
+            stack.pop_back();
+            for (size_t j = offset[w]; j < offset[w + 1]; ++j) {
+                Vertex x = target[j];
+                if (x == v or (stamp[x] != epoch and inTree(x, v)))
+                    return true;
+                if (stamp[x] == epoch or not mayReach(x, v))
+                    continue;
+                stamp[x] = epoch;
+                stack.push_back(x);
+            }
+        }
+        return false;
+    }
+
+    private:
+        /**
+         * @brief false only if u cannot reach v (u != v).
+         *
+         */
+        inline bool mayReach(Vertex u, Vertex v) const {
+            if (rank[u] >= rank[v])
+                return false;
+            const Vertex *a = &label[size_t(u) * k * 3];
+            const Vertex *b = &label[size_t(v) * k * 3];
+            for (int i = 0; i < 3 * k; i += 3) {
+                if (b[i] < a[i] or b[i + 1] > a[i + 1])
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief true only if u reaches v through DFS tree edges of some
+         * traversal.
+         *
+         */
+        inline bool inTree(Vertex u, Vertex v) const {
+            const Vertex *a = &label[size_t(u) * k * 3];
+            const Vertex *b = &label[size_t(v) * k * 3];
+            for (int i = 0; i < 3 * k; i += 3) {
+                if (a[i + 2] <= b[i + 1] and b[i + 1] <= a[i + 1])
+                    return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Iterative DFS numbering every vertex in post-order for
+         * traversal i, and setting its DFS tree interval. Sets low = post;
+         * the low values are completed by the constructor.
+         *
+         * @param i The traversal.
+         * @param roots Order in which DFS trees are started.
+         * @param salt Rotates the order of the children of every vertex.
+         */
+        void labelTraversal(int i, const std::vector<Vertex> &roots, uint32_t salt) {
+            std::vector<bool> visited(V + 1);
+            // (vertex, number of children tried)
+            std::vector<std::pair<Vertex, size_t>> stack;
+            std::vector<Vertex> entry(V + 1);
+            Vertex post = 0;
+            for (Vertex r : roots) {
+                if (visited[r])
+                    continue;
+                visited[r] = true;
+                entry[r] = post;
+                stack.push_back(std::make_pair(r, 0));
+                while (not stack.empty()) {
+                    auto &[u, tried] = stack.back();
+                    size_t deg = offset[u + 1] - offset[u];
+                    if (tried == deg) {
+                        ++post;
+                        Vertex *l = &label[(size_t(u) * k + i) * 3];
+                        l[0] = l[1] = post;
+                        l[2] = entry[u] + 1;
+                        stack.pop_back();
+                        continue;
+                    }
+                    size_t start = (uint32_t(u) * 2654435761u ^ salt) % deg;
+                    Vertex v = target[offset[u] + (start + tried) % deg];
+                    ++tried;
+                    if (not visited[v]) {
+                        visited[v] = true;
+                        entry[v] = post;
+                        stack.push_back(std::make_pair(v, 0));
+                    }
+                }
+            }
+        }
+};
+
+#endif
@@ -3,38 +3,56 @@
 #include "graph.hpp"
 
 /**
- * @brief Helps topologicalSort by recursively applying DFS. Reversed topological ordering is stored in
- * order
+ * @brief Helps topologicalSort by applying DFS with an explicit stack, so deep
+ * graphs do not overflow the call stack. Reversed topological ordering is stored
+ * in order
  *
  * @param G The Graph Object.
  * @param u The vertex on which DFS is to be performed.
  * @param order The vector container in which reverse topological ordering is stored.
  * @param visited The vector boolean container to keep track of visited vertices.
  */
+template <class GraphT>
 void 
-topoSortUtil(const Graph &G, Vertex u, std::vector<Vertex> &order, std::vector<bool> &visited) {
+topoSortUtil(const GraphT &G, Vertex u, std::vector<Vertex> &order, std::vector<bool> &visited) {
+    using Iterator = decltype(G.getAdj(u).begin());
+    struct Frame {
+        Vertex u;
+        Iterator next, end;
+    };
+    std::vector<Frame> stack;
+
     visited[u] = true;
-    const std::vector<Vertex> & adj = G.getAdj(u);
-    for (Vertex v : adj) {
-        if (not visited[v]) 
-            topoSortUtil(G, v, order, visited);
+    stack.push_back(Frame{u, G.getAdj(u).begin(), G.getAdj(u).end()});
+    while (not stack.empty()) {
+        Frame &top = stack.back();
+        if (top.next == top.end) {
+            order.push_back(top.u);
+            stack.pop_back();
+            continue;
+        }
+        Vertex v = *top.next;
+        ++top.next;
+        if (not visited[v]) {
+            visited[v] = true;
+            stack.push_back(Frame{v, G.getAdj(v).begin(), G.getAdj(v).end()});
+        }
     }
-    order.push_back(u);
 }
 
-
 /**
- * @brief Prints a topological ordering of the vertices if the Graph 
- * is an DAG. Prints an error message if the Graph is not an DAG.
+ * @brief Finds a topological ordering of the vertices.
  * 
- * @param G The Graph object
- * @param err Default = "IMPOSSIBLE". The error message to be prited
- * if the graph is not an DAG.
+ * @param G The Graph object, or any graph exposing getV() and getAdj(u)
+ * such as compressedGraph.
+ * @return std::vector<Vertex> The topological ordering, empty if the Graph
+ * is not an DAG.
  */
-void 
-topologicalSort(const Graph &G, const std::string& err = "IMPOSSIBLE") {
+template <class GraphT>
+std::vector<Vertex> 
+topologicalOrder(const GraphT &G) {
     int V = G.getV();
-    int pos[V + 1]={};
+    std::vector<int> pos(V + 1);
     std::vector<Vertex> topologicalOrdering;
     topologicalOrdering.reserve(V);
     std::vector<bool> visited(V + 1);
@@ -52,14 +70,34 @@ topologicalSort(const Graph &G, const std::string& err = "IMPOSSIBLE") {
     }
 
     for (Vertex i = Vertex(1); i <= V; ++i) {
-        const std::vector<Vertex> &adj = G.getAdj(i);
+        const auto &adj = G.getAdj(i);
         for (Vertex v : adj) {
-            if (pos[v] < pos[i]) {
-                std::cout << err << "\n";
-                return; 
+            if (pos[v] <= pos[i]) { // a self loop is a cycle too
+                topologicalOrdering.clear();
+                return topologicalOrdering; 
             }
         }
     }
+    return topologicalOrdering;
+}
+
+/**
+ * @brief Prints a topological ordering of the vertices if the Graph 
+ * is an DAG. Prints an error message if the Graph is not an DAG.
+ * 
+ * @param G The Graph object, or any graph exposing getV() and getAdj(u)
+ * such as compressedGraph.
+ * @param err Default = "IMPOSSIBLE". The error message to be prited
+ * if the graph is not an DAG.
+ */
+template <class GraphT>
+void 
+topologicalSort(const GraphT &G, const std::string& err = "IMPOSSIBLE") {
+    std::vector<Vertex> topologicalOrdering = topologicalOrder(G);
+    if (Vertex(topologicalOrdering.size()) != G.getV()) {
+        std::cout << err << "\n";
+        return;
+    }
 
     for (int u : topologicalOrdering) {
         std::cout << u << ' ';
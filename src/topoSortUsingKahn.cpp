@@ -3,24 +3,25 @@
 #include "graph.hpp" 
 
 /**
- * @brief Prints a topological ordering of the vertices if the Graph 
- * is an DAG. Prints an error message if the Graph is not an DAG.
+ * @brief Finds a topological ordering of the vertices.
  * 
- * @param G The Graph object
- * @param err Default = "IMPOSSIBLE". The error message to be prited
- * if the graph is not an DAG.
+ * @param G The Graph object, or any graph exposing getV() and getAdj(u)
+ * such as compressedGraph.
+ * @return std::vector<Vertex> The topological ordering, empty if the Graph
+ * is not an DAG.
  */
-void
-topologicalSort(const Graph &G, const std::string& err = "IMPOSSIBLE") {
+template <class GraphT>
+std::vector<Vertex>
+topologicalOrder(const GraphT &G) {
     int V = G.getV();
-    Vertex inDegree[V + 1]={};
+    std::vector<Vertex> inDegree(V + 1);
     std::queue<Vertex> Q;
     std::vector<Vertex> topologicalOrdering;
     topologicalOrdering.reserve(V);
 
     // Count incoming edges for all vertices
     for (Vertex u = Vertex(1); u <= V; ++u) {
-        const std::vector<Vertex> & adj = G.getAdj(u);
+        const auto &adj = G.getAdj(u);
         for (Vertex v : adj) {
             inDegree[v]++;
         }
@@ -38,7 +39,7 @@ topologicalSort(const Graph &G, const std::string& err = "IMPOSSIBLE") {
 
         topologicalOrdering.push_back(u);
 
-        const std::vector<Vertex> & adj = G.getAdj(u);
+        const auto &adj = G.getAdj(u);
         for (Vertex v : adj) {
 
             // Decrement in-degree of adjacent vertex
@@ -50,7 +51,25 @@ topologicalSort(const Graph &G, const std::string& err = "IMPOSSIBLE") {
         }
     }
 
-    if (Vertex(topologicalOrdering.size()) != V) {
+    if (Vertex(topologicalOrdering.size()) != V) 
+        topologicalOrdering.clear();
+    return topologicalOrdering;
+}
+
+/**
+ * @brief Prints a topological ordering of the vertices if the Graph 
+ * is an DAG. Prints an error message if the Graph is not an DAG.
+ * 
+ * @param G The Graph object, or any graph exposing getV() and getAdj(u)
+ * such as compressedGraph.
+ * @param err Default = "IMPOSSIBLE". The error message to be prited
+ * if the graph is not an DAG.
+ */
+template <class GraphT>
+void
+topologicalSort(const GraphT &G, const std::string& err = "IMPOSSIBLE") {
+    std::vector<Vertex> topologicalOrdering = topologicalOrder(G);
+    if (Vertex(topologicalOrdering.size()) != G.getV()) {
         std::cout << err << "\n";
         return;
     }